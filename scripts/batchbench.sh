@@ -0,0 +1,63 @@
+#!/bin/bash
+# Compare batch mode against one mmu process per run for the same manifest.
+# usage: batchbench.sh <mmu> <manifest> [threads]
+# Manifest lines: inputfile randomfile num_frames algo options outputfile
+#
+# Runs the manifest three ways, each writing to its own scratch directory
+# (the manifest's outputfile column is ignored):
+#   PROCESS  one mmu per job, debug trace written to /dev/null
+#   QUIET    one mmu -q per job, debug trace disabled
+#   BATCH    mmu -b with [threads] workers (default 1), debug disabled;
+#            WALL is the same run timed from outside, including startup
+# QUIET vs BATCH isolates the in-process gain from the debug-output gain.
+# All outputs are then compared with cmp.
+
+MMU=${1:?usage: $0 <mmu> <manifest> [threads]}
+MANIFEST=${2:?usage: $0 <mmu> <manifest> [threads]}
+THREADS=${3:-1}
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+mkdir "$TMP/process" "$TMP/quiet" "$TMP/batch"
+
+now() { date +%s.%N; }
+rate() {
+    awk -v m="$1" -v n="$2" -v s="$3" -v e="$4" \
+        'BEGIN { printf "%-7s jobs=%d elapsed=%.3fs jobs/s=%.1f\n", m, n, e - s, n / (e - s) }'
+}
+
+# Job n writes to <dir>/n in every mode
+jobs=0
+while read -r input rfile frames algo opts out; do
+    [[ -z "$input" || "$input" == \#* ]] && continue
+    jobs=$((jobs + 1))
+    echo "$input $rfile $frames $algo $opts $TMP/batch/$jobs"
+done < "$MANIFEST" > "$TMP/manifest"
+
+run_each() {
+    local dir=$1; shift
+    local n=0
+    while read -r input rfile frames algo opts out; do
+        n=$((n + 1))
+        [[ "$opts" == "-" ]] && opts=""
+        "$MMU" "$@" -f"$frames" -a"$algo" ${opts:+-o"$opts"} "$input" "$rfile" > "$dir/$n" 2> /dev/null
+    done < "$TMP/manifest"
+}
+
+start=$(now); run_each "$TMP/process"; end=$(now)
+rate PROCESS "$jobs" "$start" "$end"
+
+start=$(now); run_each "$TMP/quiet" -q; end=$(now)
+rate QUIET "$jobs" "$start" "$end"
+
+# mmu -b prints its own in-process rate; WALL also counts its startup
+start=$(now); "$MMU" -b"$TMP/manifest" -j"$THREADS"; end=$(now)
+rate WALL "$jobs" "$start" "$end"
+
+diffs=0
+for ((n = 1; n <= jobs; n++)); do
+    cmp -s "$TMP/process/$n" "$TMP/batch/$n" || { echo "output differs: job $n (process vs batch)"; diffs=$((diffs + 1)); }
+    cmp -s "$TMP/quiet/$n" "$TMP/batch/$n" || { echo "output differs: job $n (quiet vs batch)"; diffs=$((diffs + 1)); }
+done
+echo "COMPARE jobs=$jobs mismatches=$diffs"
+[[ $diffs -eq 0 ]]
@@ -0,0 +1,144 @@
+#include "batch.h"
+#include "sim.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+bool read_manifest(const std::string &filename, std::vector<BatchJob> &jobs) {
+    std::ifstream file(filename);
+    if (!file) return false;
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        BatchJob job;
+        std::string algo;
+        if (!(iss >> job.inputfile >> job.randfile >> job.num_frames >> algo >> job.options >> job.outfile)
+            || job.num_frames <= 0 || job.num_frames > MAX_FRAMES
+            || algo.size() != 1 || !strchr("frceaw", algo[0])) {
+            std::cerr << filename << ":" << line_no << ": invalid manifest entry\n";
+            return false;
+        }
+        job.algo = algo[0];
+        if (job.options == "-") job.options.clear();
+        jobs.push_back(job);
+    }
+    file.close();
+    return true;
+}
+
+// Per-worker job queue. The owner pops from the back, thieves take from the
+// front, so an idle worker steals the jobs its owner would reach last.
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<size_t> jobs;
+
+    bool pop(size_t &job) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (jobs.empty()) return false;
+        job = jobs.back();
+        jobs.pop_back();
+        return true;
+    }
+
+    bool steal(size_t &job) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (jobs.empty()) return false;
+        job = jobs.front();
+        jobs.pop_front();
+        return true;
+    }
+};
+
+static bool run_job(SimContext &ctx, const BatchJob &job, const std::vector<int> &random_values) {
+    if (job.algo == 'r' && random_values.empty()) {
+        std::cerr << "Cannot read randomfile " << job.randfile << " for " << job.outfile << "\n";
+        return false;
+    }
+    ctx.reset();
+    if (!read_input(ctx, job.inputfile)) return false;
+    Pager *pager = create_pager(job.algo, &ctx, random_values);
+    if (!pager) {
+        std::cerr << "Invalid algorithm '" << job.algo << "' for " << job.outfile << "\n";
+        return false;
+    }
+    FILE *out = fopen(job.outfile.c_str(), "w");
+    if (!out) {
+        std::cerr << "Cannot open outputfile " << job.outfile << "\n";
+        delete pager;
+        return false;
+    }
+    ctx.out = out;
+    bool ok = true;
+    // A failing job must not take the rest of the batch down with it
+    try {
+        init_frame_table(ctx, job.num_frames);
+        simulate(ctx, pager, job.num_frames, job.options);
+    } catch (const std::exception &e) {
+        std::cerr << "Job " << job.outfile << " failed: " << e.what() << "\n";
+        ok = false;
+    }
+    fclose(out);
+    delete pager;
+    return ok;
+}
+
+int run_batch(const std::vector<BatchJob> &jobs, int num_threads) {
+    if (num_threads <= 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Random files are shared by most jobs, load each one once up front.
+    // A missing or empty file fails only the jobs that use it.
+    std::map<std::string, std::vector<int>> random_files;
+    for (const auto &job : jobs) {
+        if (job.algo == 'r' && !random_files.count(job.randfile)) {
+            random_files[job.randfile] = load_random_values(job.randfile);
+        }
+    }
+    const std::vector<int> no_random_values;
+
+    std::vector<WorkQueue> queues(num_threads);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        queues[i % num_threads].jobs.push_back(i);
+    }
+
+    std::atomic<unsigned long> failed(0);
+    auto worker = [&](int id) {
+        SimContext ctx;
+        ctx.dbg = nullptr;
+        size_t job;
+        while (true) {
+            bool found = queues[id].pop(job);
+            for (int i = 1; !found && i < num_threads; ++i) {
+                found = queues[(id + i) % num_threads].steal(job);
+            }
+            // Jobs are only queued up front, so all queues empty means done
+            if (!found) break;
+            auto it = random_files.find(jobs[job].randfile);
+            const std::vector<int> &random_values = it != random_files.end() ? it->second : no_random_values;
+            if (!run_job(ctx, jobs[job], random_values)) failed++;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) threads.emplace_back(worker, i);
+    for (auto &t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("BATCH jobs=%zu failed=%lu threads=%d elapsed=%.3fs jobs/s=%.1f\n",
+           jobs.size(), failed.load(), num_threads, elapsed,
+           elapsed > 0 ? jobs.size() / elapsed : 0.0);
+    return failed ? 1 : 0;
+}
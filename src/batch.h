@@ -0,0 +1,22 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+
+// One line of a batch manifest:
+//   inputfile randomfile num_frames algo options outputfile
+// options is "-" when no output options are wanted.
+struct BatchJob {
+    std::string inputfile;
+    std::string randfile;
+    int num_frames;
+    char algo;
+    std::string options;
+    std::string outfile;
+};
+
+bool read_manifest(const std::string &filename, std::vector<BatchJob> &jobs);
+int run_batch(const std::vector<BatchJob> &jobs, int num_threads);
+
+#endif
@@ -3,39 +3,40 @@
 #include <fstream>
 #include <sstream>
 
-extern frame_t frame_table[MAX_FRAMES];
-extern std::vector<Process> processes;
-extern unsigned long long inst_count;
-
-FIFO_Pager::FIFO_Pager() : hand(0) {}
+FIFO_Pager::FIFO_Pager(SimContext *ctx) : Pager(ctx), hand(0) {}
 
 frame_t* FIFO_Pager::select_victim_frame() {
-    frame_t *victim = &frame_table[hand];
+    frame_t *victim = &ctx->frame_table[hand];
     hand = (hand + 1) % MAX_FRAMES;
     return victim;
 }
 
-Random_Pager::Random_Pager(const std::string &randfile, int num_frames) : ofs(0) {
+std::vector<int> load_random_values(const std::string &randfile) {
+    std::vector<int> random_values;
     std::ifstream file(randfile);
     int value;
     while (file >> value) {
         random_values.push_back(value);
     }
     file.close();
+    return random_values;
 }
 
+Random_Pager::Random_Pager(SimContext *ctx, const std::vector<int> &random_values)
+    : Pager(ctx), random_values(random_values), ofs(0) {}
+
 frame_t* Random_Pager::select_victim_frame() {
     int r = random_values[ofs] % MAX_FRAMES;
     ofs = (ofs + 1) % random_values.size();
-    return &frame_table[r];
+    return &ctx->frame_table[r];
 }
 
-Clock_Pager::Clock_Pager() : hand(0) {}
+Clock_Pager::Clock_Pager(SimContext *ctx) : Pager(ctx), hand(0) {}
 
 frame_t* Clock_Pager::select_victim_frame() {
     while (true) {
-        frame_t *frame = &frame_table[hand];
-        Process *proc = &processes[frame->proc_id];
+        frame_t *frame = &ctx->frame_table[hand];
+        Process *proc = &ctx->processes[frame->proc_id];
         pte_t *pte = &proc->page_table[frame->vpage];
         if (pte->referenced) {
             pte->referenced = 0;
@@ -47,19 +48,19 @@ frame_t* Clock_Pager::select_victim_frame() {
     }
 }
 
-NRU_Pager::NRU_Pager() : hand(0), last_reset(0) {}
+NRU_Pager::NRU_Pager(SimContext *ctx) : Pager(ctx), hand(0), last_reset(0) {}
 
 frame_t* NRU_Pager::select_victim_frame() {
     // Reset reference bits every 10 instructions
-    if (inst_count - last_reset >= 10) {
+    if (ctx->inst_count - last_reset >= 10) {
         for (int i = 0; i < MAX_FRAMES; ++i) {
-            if (frame_table[i].proc_id != -1) {
-                Process *proc = &processes[frame_table[i].proc_id];
-                pte_t *pte = &proc->page_table[frame_table[i].vpage];
+            if (ctx->frame_table[i].proc_id != -1) {
+                Process *proc = &ctx->processes[ctx->frame_table[i].proc_id];
+                pte_t *pte = &proc->page_table[ctx->frame_table[i].vpage];
                 pte->referenced = 0;
             }
         }
-        last_reset = inst_count;
+        last_reset = ctx->inst_count;
     }
 
     // NRU classes: (0) not referenced, not modified; (1) not referenced, modified;
@@ -69,9 +70,9 @@ frame_t* NRU_Pager::select_victim_frame() {
     int start_hand = hand;
 
     do {
-        frame_t *frame = &frame_table[hand];
+        frame_t *frame = &ctx->frame_table[hand];
         if (frame->proc_id != -1) {
-            Process *proc = &processes[frame->proc_id];
+            Process *proc = &ctx->processes[frame->proc_id];
             pte_t *pte = &proc->page_table[frame->vpage];
             int nru_class = (pte->referenced << 1) | pte->modified;
             if (nru_class < min_class) {
@@ -88,10 +89,10 @@ frame_t* NRU_Pager::select_victim_frame() {
         hand = (hand + 1) % MAX_FRAMES;
     }
 
-    return &frame_table[victim_frame];
+    return &ctx->frame_table[victim_frame];
 }
 
-Aging_Pager::Aging_Pager() : hand(0) {
+Aging_Pager::Aging_Pager(SimContext *ctx) : Pager(ctx), hand(0) {
     for (int i = 0; i < MAX_FRAMES; ++i) {
         age[i] = 0;
     }
@@ -104,9 +105,9 @@ frame_t* Aging_Pager::select_victim_frame() {
 
     // Update ages and find minimum
     do {
-        frame_t *frame = &frame_table[hand];
+        frame_t *frame = &ctx->frame_table[hand];
         if (frame->proc_id != -1) {
-            Process *proc = &processes[frame->proc_id];
+            Process *proc = &ctx->processes[frame->proc_id];
             pte_t *pte = &proc->page_table[frame->vpage];
             // Shift right and add referenced bit as MSB
             age[hand] >>= 1;
@@ -127,7 +128,7 @@ frame_t* Aging_Pager::select_victim_frame() {
         hand = (hand + 1) % MAX_FRAMES;
     }
 
-    frame_t *victim = &frame_table[victim_frame];
+    frame_t *victim = &ctx->frame_table[victim_frame];
     age[victim_frame] = 0; // Reset age on eviction
     hand = (victim_frame + 1) % MAX_FRAMES;
     return victim;
@@ -137,24 +138,24 @@ void Aging_Pager::reset_age(int frame) {
     age[frame] = 0;
 }
 
-WorkingSet_Pager::WorkingSet_Pager() : hand(0) {}
+WorkingSet_Pager::WorkingSet_Pager(SimContext *ctx) : Pager(ctx), hand(0) {}
 
 frame_t* WorkingSet_Pager::select_victim_frame() {
     const unsigned long long TAU = 49;
     int start_hand = hand;
-    unsigned long long oldest_time = inst_count;
+    unsigned long long oldest_time = ctx->inst_count;
     int oldest_frame = -1;
 
     do {
-        frame_t *frame = &frame_table[hand];
+        frame_t *frame = &ctx->frame_table[hand];
         if (frame->proc_id != -1) {
-            Process *proc = &processes[frame->proc_id];
+            Process *proc = &ctx->processes[frame->proc_id];
             pte_t *pte = &proc->page_table[frame->vpage];
             if (pte->referenced) {
                 // Referenced recently, reset last_used and clear reference bit
-                frame->last_used = inst_count;
+                frame->last_used = ctx->inst_count;
                 pte->referenced = 0;
-            } else if (inst_count - frame->last_used > TAU) {
+            } else if (ctx->inst_count - frame->last_used > TAU) {
                 // Not referenced within TAU, select as victim
                 hand = (hand + 1) % MAX_FRAMES;
                 return frame;
@@ -174,7 +175,19 @@ frame_t* WorkingSet_Pager::select_victim_frame() {
         hand = (hand + 1) % MAX_FRAMES;
     }
 
-    frame_t *victim = &frame_table[oldest_frame];
+    frame_t *victim = &ctx->frame_table[oldest_frame];
     hand = (oldest_frame + 1) % MAX_FRAMES;
     return victim;
+}
+
+Pager* create_pager(char algo, SimContext *ctx, const std::vector<int> &random_values) {
+    switch (algo) {
+        case 'f': return new FIFO_Pager(ctx);
+        case 'r': return new Random_Pager(ctx, random_values);
+        case 'c': return new Clock_Pager(ctx);
+        case 'e': return new NRU_Pager(ctx);
+        case 'a': return new Aging_Pager(ctx);
+        case 'w': return new WorkingSet_Pager(ctx);
+        default: return nullptr;
+    }
 }
\ No newline at end of file
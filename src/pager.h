@@ -7,14 +7,17 @@
 
 class Pager {
 public:
+    explicit Pager(SimContext *ctx) : ctx(ctx) {}
     virtual ~Pager() = default;
     virtual frame_t* select_victim_frame() = 0;
     virtual void reset_age(int frame) {}
+protected:
+    SimContext *ctx;
 };
 
 class FIFO_Pager : public Pager {
 public:
-    FIFO_Pager();
+    FIFO_Pager(SimContext *ctx);
     frame_t* select_victim_frame() override;
 private:
     int hand;
@@ -22,16 +25,16 @@ private:
 
 class Random_Pager : public Pager {
 public:
-    Random_Pager(const std::string &randfile, int num_frames);
+    Random_Pager(SimContext *ctx, const std::vector<int> &random_values);
     frame_t* select_victim_frame() override;
 private:
-    std::vector<int> random_values;
+    const std::vector<int> &random_values; // Shared, read-only across runs
     int ofs;
 };
 
 class Clock_Pager : public Pager {
 public:
-    Clock_Pager();
+    Clock_Pager(SimContext *ctx);
     frame_t* select_victim_frame() override;
 private:
     int hand;
@@ -39,7 +42,7 @@ private:
 
 class NRU_Pager : public Pager {
 public:
-    NRU_Pager();
+    NRU_Pager(SimContext *ctx);
     frame_t* select_victim_frame() override;
 private:
     int hand;
@@ -48,7 +51,7 @@ private:
 
 class Aging_Pager : public Pager {
 public:
-    Aging_Pager();
+    Aging_Pager(SimContext *ctx);
     frame_t* select_victim_frame() override;
     void reset_age(int frame) override;
 private:
@@ -58,10 +61,13 @@ private:
 
 class WorkingSet_Pager : public Pager {
 public:
-    WorkingSet_Pager();
+    WorkingSet_Pager(SimContext *ctx);
     frame_t* select_victim_frame() override;
 private:
     int hand;
 };
 
+std::vector<int> load_random_values(const std::string &randfile);
+Pager* create_pager(char algo, SimContext *ctx, const std::vector<int> &random_values);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "sim.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+#ifdef _WIN32
+#define PRIu64 "I64u"
+#define PRIzu "u"
+#else
+#define PRIu64 "llu"
+#define PRIzu "zu"
+#endif
+
+// Debug tracing goes to ctx.dbg; batch jobs leave it null to run quietly.
+#define DEBUG(ctx, ...) do { if ((ctx).dbg) fprintf((ctx).dbg, __VA_ARGS__); } while (0)
+
+// Reads the next line that is not blank or a '#' comment
+static bool next_line(std::ifstream &file, std::string &line, int &line_no) {
+    while (std::getline(file, line)) {
+        ++line_no;
+        if (!line.empty() && line[0] != '#') return true;
+    }
+    return false;
+}
+
+static bool input_error(const std::string &filename, int line_no) {
+    std::cerr << filename << ":" << line_no << ": invalid input\n";
+    return false;
+}
+
+bool read_input(SimContext &ctx, const std::string &filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        std::cerr << "Cannot open inputfile " << filename << "\n";
+        return false;
+    }
+    std::string line;
+    int line_no = 0;
+    int num_processes;
+    if (!next_line(file, line, line_no) || sscanf(line.c_str(), "%d", &num_processes) != 1 || num_processes <= 0) {
+        return input_error(filename, line_no);
+    }
+    // Reuse the process slots of a previous run so their VMA storage is kept
+    if ((int)ctx.processes.size() < num_processes) ctx.processes.resize(num_processes);
+    ctx.num_processes = num_processes;
+    for (int i = 0; i < num_processes; ++i) {
+        Process &proc = ctx.processes[i];
+        proc.pid = i;
+        proc.vmas.clear();
+        proc.unmaps = proc.maps = proc.ins = proc.outs = proc.fins = proc.fouts = proc.zeros = proc.segv = proc.segprot = 0;
+        for (int j = 0; j < MAX_VPAGES; ++j) {
+            proc.page_table[j] = {0};
+        }
+        int num_vmas;
+        if (!next_line(file, line, line_no) || sscanf(line.c_str(), "%d", &num_vmas) != 1 || num_vmas < 0) {
+            return input_error(filename, line_no);
+        }
+        for (int j = 0; j < num_vmas; ++j) {
+            VMA vma;
+            if (!next_line(file, line, line_no)
+                || sscanf(line.c_str(), "%d %d %d %d", &vma.start_vpage, &vma.end_vpage,
+                          &vma.write_protected, &vma.file_mapped) != 4
+                || vma.start_vpage < 0 || vma.start_vpage > vma.end_vpage || vma.end_vpage >= MAX_VPAGES) {
+                return input_error(filename, line_no);
+            }
+            proc.vmas.push_back(vma);
+        }
+    }
+    // Reject anything simulate() would index out of range with
+    int current = -1;
+    while (next_line(file, line, line_no)) {
+        Instruction inst;
+        if (sscanf(line.c_str(), " %c %d", &inst.op, &inst.value) != 2) return input_error(filename, line_no);
+        if (inst.op == 'c' || inst.op == 'e') {
+            if (inst.value < 0 || inst.value >= num_processes) return input_error(filename, line_no);
+            if (inst.op == 'c') current = inst.value;
+            else if (inst.value == current) current = -1;
+        } else if (inst.op == 'r' || inst.op == 'w') {
+            if (current == -1 || inst.value < 0 || inst.value >= MAX_VPAGES) return input_error(filename, line_no);
+        } else {
+            return input_error(filename, line_no);
+        }
+        ctx.instructions.push_back(inst);
+    }
+    file.close();
+    return true;
+}
+
+void init_frame_table(SimContext &ctx, int num_frames) {
+    for (int i = 0; i < num_frames; ++i) {
+        ctx.frame_table[i].proc_id = -1;
+        ctx.frame_table[i].vpage = -1;
+        ctx.frame_table[i].age = 0;
+        ctx.frame_table[i].last_used = 0;
+        ctx.free_frames.push_back(i);
+    }
+}
+
+frame_t* get_frame(SimContext &ctx, Pager *pager, int num_frames) {
+    if (!ctx.free_frames.empty()) {
+        int frame_id = ctx.free_frames.front();
+        ctx.free_frames.pop_front();
+        DEBUG(ctx, "DEBUG: Allocated free frame %d\n", frame_id);
+        return &ctx.frame_table[frame_id];
+    }
+    frame_t *victim = pager->select_victim_frame();
+    DEBUG(ctx, "DEBUG: Selected victim frame %d (proc %d, vpage %d)\n", 
+            (int)(victim - ctx.frame_table), victim->proc_id, victim->vpage);
+    return victim;
+}
+
+bool is_in_vma(Process *proc, int vpage, VMA &out_vma) {
+    for (const auto &vma : proc->vmas) {
+        if (vpage >= vma.start_vpage && vpage <= vma.end_vpage) {
+            out_vma = vma;
+            return true;
+        }
+    }
+    return false;
+}
+
+void handle_page_fault(SimContext &ctx, Process *proc, int vpage, char op, Pager *pager, int num_frames, bool output_O) {
+    pte_t *pte = &proc->page_table[vpage];
+    VMA vma;
+    if (!is_in_vma(proc, vpage, vma)) {
+        if (output_O) fprintf(ctx.out, "%" PRIu64 ": ==> %c %d\nSEGV\n", ctx.inst_count, op, vpage);
+        proc->segv++;
+        ctx.cost += 444;
+        DEBUG(ctx, "DEBUG: Cost after SEGV (proc %d, vpage %d) = %llu\n", proc->pid, vpage, ctx.cost);
+        DEBUG(ctx, "DEBUG: SEGV on proc %d, vpage %d\n", proc->pid, vpage);
+        return;
+    }
+    frame_t *newframe = get_frame(ctx, pager, num_frames);
+    if (newframe->proc_id != -1) {
+        Process *old_proc = &ctx.processes[newframe->proc_id];
+        pte_t *old_pte = &old_proc->page_table[newframe->vpage];
+        if (output_O) fprintf(ctx.out, "UNMAP %d:%d\n", newframe->proc_id, newframe->vpage);
+        old_proc->unmaps++;
+        ctx.cost += 400;
+        DEBUG(ctx, "DEBUG: Cost after UNMAP (proc %d, vpage %d) = %llu\n", newframe->proc_id, newframe->vpage, ctx.cost);
+        DEBUG(ctx, "DEBUG: Unmapping proc %d, vpage %d, frame %d, modified=%d, file_mapped=%d\n",
+                newframe->proc_id, newframe->vpage, (int)(newframe - ctx.frame_table), 
+                old_pte->modified, old_pte->file_mapped);
+        if (old_pte->modified && old_pte->file_mapped) {
+            if (output_O) fprintf(ctx.out, "FOUT\n");
+            old_proc->fouts++;
+            ctx.cost += 1523;
+            DEBUG(ctx, "DEBUG: Cost after FOUT (proc %d, vpage %d) = %llu\n", newframe->proc_id, newframe->vpage, ctx.cost);
+            DEBUG(ctx, "DEBUG: FOUT for proc %d, vpage %d\n", newframe->proc_id, newframe->vpage);
+        }
+        old_pte->present = 0;
+        old_pte->frame = 0;
+        old_pte->referenced = 0;
+        old_pte->modified = 0;
+        ctx.free_frames.push_back(newframe - ctx.frame_table);
+    }
+    if (vma.file_mapped) {
+        if (output_O) fprintf(ctx.out, "FIN\n");
+        proc->fins++;
+        ctx.cost += 1500;
+        DEBUG(ctx, "DEBUG: Cost after FIN (proc %d, vpage %d) = %llu\n", proc->pid, vpage, ctx.cost);
+        DEBUG(ctx, "DEBUG: FIN (first access) for proc %d, vpage %d\n", proc->pid, vpage);
+    } else {
+        if (output_O) fprintf(ctx.out, "ZERO\n");
+        proc->zeros++;
+        ctx.cost += 140;
+        DEBUG(ctx, "DEBUG: Cost after ZERO (proc %d, vpage %d) = %llu\n", proc->pid, vpage, ctx.cost);
+        DEBUG(ctx, "DEBUG: ZERO for proc %d, vpage %d\n", proc->pid, vpage);
+    }
+    if (output_O) fprintf(ctx.out, "MAP %d\n", (int)(newframe - ctx.frame_table));
+    proc->maps++;
+    ctx.cost += 300;
+    DEBUG(ctx, "DEBUG: Cost after MAP (proc %d, vpage %d) = %llu\n", proc->pid, vpage, ctx.cost);
+    pte->present = 1;
+    pte->frame = newframe - ctx.frame_table;
+    pte->write_protect = vma.write_protected;
+    pte->file_mapped = vma.file_mapped;
+    pte->referenced = 1;
+    if (!pte->pagedout) pte->pagedout = 1;
+    if (op == 'w' && !vma.write_protected) pte->modified = 1;
+    else if (op == 'r' && !vma.file_mapped) pte->modified = 1;
+    else if (op == 'r' && vma.file_mapped) pte->modified = 1;
+    if (op == 'w' && vma.write_protected) {
+        if (output_O) fprintf(ctx.out, "SEGPROT\n");
+        proc->segprot++;
+        ctx.cost += 340;
+        DEBUG(ctx, "DEBUG: Cost after SEGPROT (proc %d, vpage %d) = %llu\n", proc->pid, vpage, ctx.cost);
+        DEBUG(ctx, "DEBUG: SEGPROT for proc %d, vpage %d, pagedout=1\n", proc->pid, vpage);
+    }
+    newframe->proc_id = proc->pid;
+    newframe->vpage = vpage;
+    pager->reset_age(pte->frame);
+    newframe->last_used = ctx.inst_count;
+    DEBUG(ctx, "DEBUG: Mapped frame %d to proc %d, vpage %d, modified=%d, pagedout=%d, file_mapped=%d\n",
+            (int)(newframe - ctx.frame_table), proc->pid, vpage, pte->modified, pte->pagedout, pte->file_mapped);
+}
+
+void print_page_table(SimContext &ctx, const Process &proc, bool all) {
+    fprintf(ctx.out, "PT[%d]: ", proc.pid);
+    for (int i = 0; i < MAX_VPAGES; ++i) {
+        const pte_t *pte = &proc.page_table[i];
+        if (pte->present) {
+            fprintf(ctx.out, "%d:%c%c%c ", i,
+                   pte->referenced ? 'R' : '-',
+                   pte->modified ? 'M' : '-',
+                   pte->pagedout ? 'S' : '-');
+        } else {
+            fprintf(ctx.out, "%c ", pte->pagedout ? '#' : '*');
+        }
+    }
+    fprintf(ctx.out, "\n");
+}
+
+void simulate(SimContext &ctx, Pager *pager, int num_frames, const std::string &options) {
+    bool output_O = options.find('O') != std::string::npos;
+    bool output_P = options.find('P') != std::string::npos;
+    bool output_F = options.find('F') != std::string::npos;
+    bool output_S = options.find('S') != std::string::npos;
+    bool output_x = options.find('x') != std::string::npos;
+    bool output_y = options.find('y') != std::string::npos;
+    bool output_f = options.find('f') != std::string::npos;
+
+    for (const auto &inst : ctx.instructions) {
+        if (output_O) fprintf(ctx.out, "%" PRIu64 ": ==> %c %d\n", ctx.inst_count, inst.op, inst.value);
+        if (inst.op == 'c') {
+            Process *new_process = &ctx.processes[inst.value];
+            if (ctx.current_process != new_process && (ctx.current_process != nullptr || ctx.ctx_switches == 0)) {
+                ctx.ctx_switches++;
+                ctx.cost += 130;
+                DEBUG(ctx, "DEBUG: Cost after context switch (%c %d) = %llu\n", inst.op, inst.value, ctx.cost);
+                DEBUG(ctx, "DEBUG: Context switch to proc %d, ctx_switches=%llu\n", 
+                        new_process->pid, ctx.ctx_switches);
+            } else {
+                DEBUG(ctx, "DEBUG: No context switch, staying on proc %d\n", new_process->pid);
+            }
+            ctx.current_process = new_process;
+        } else if (inst.op == 'e') {
+            Process *exiting_process = &ctx.processes[inst.value];
+            for (int i = 0; i < MAX_VPAGES; ++i) {
+                pte_t *pte = &exiting_process->page_table[i];
+                if (pte->present) {
+                    if (output_O) fprintf(ctx.out, "UNMAP %d:%d\n", exiting_process->pid, i);
+                    exiting_process->unmaps++;
+                    ctx.cost += 400;
+                    DEBUG(ctx, "DEBUG: Cost after UNMAP (proc %d, vpage %d) = %llu\n", exiting_process->pid, i, ctx.cost);
+                    DEBUG(ctx, "DEBUG: Process exit, unmapping proc %d, vpage %d, frame %d, modified=%d, file_mapped=%d\n",
+                            exiting_process->pid, i, pte->frame, pte->modified, pte->file_mapped);
+                    if (pte->modified && pte->file_mapped) {
+                        if (output_O) fprintf(ctx.out, "FOUT\n");
+                        exiting_process->fouts++;
+                        ctx.cost += 1523;
+                        DEBUG(ctx, "DEBUG: Cost after FOUT (proc %d, vpage %d) = %llu\n", exiting_process->pid, i, ctx.cost);
+                        DEBUG(ctx, "DEBUG: FOUT for proc %d, vpage %d\n", exiting_process->pid, i);
+                    }
+                    ctx.free_frames.push_back(pte->frame);
+                    DEBUG(ctx, "DEBUG: Freed frame %d during process exit\n", pte->frame);
+                    pte->present = 0;
+                    pte->frame = 0;
+                    pte->referenced = 0;
+                    pte->modified = 0;
+                    pte->write_protect = 0;
+                    pte->file_mapped = 0;
+                    pte->pagedout = 0;
+                }
+            }
+            ctx.process_exits++;
+            ctx.cost += 400;
+            DEBUG(ctx, "DEBUG: Cost after process exit (%c %d) = %llu\n", inst.op, inst.value, ctx.cost);
+            DEBUG(ctx, "DEBUG: Process %d exited, process_exits=%llu\n", exiting_process->pid, ctx.process_exits);
+            if (ctx.current_process == exiting_process) {
+                ctx.current_process = nullptr;
+                DEBUG(ctx, "DEBUG: Current process set to nullptr\n");
+            }
+        } else {
+            int vpage = inst.value;
+            pte_t *pte = &ctx.current_process->page_table[vpage];
+            if (!pte->present) {
+                handle_page_fault(ctx, ctx.current_process, vpage, inst.op, pager, num_frames, output_O);
+            } else {
+                if (inst.op == 'w' && pte->write_protect) {
+                    if (output_O) fprintf(ctx.out, "SEGPROT\n");
+                    ctx.current_process->segprot++;
+                    ctx.cost += 340;
+                    DEBUG(ctx, "DEBUG: Cost after SEGPROT (proc %d, vpage %d) = %llu\n", ctx.current_process->pid, vpage, ctx.cost);
+                    DEBUG(ctx, "DEBUG: SEGPROT on proc %d, vpage %d, pagedout=1\n", ctx.current_process->pid, vpage);
+                    pte->referenced = 1;
+                    pte->pagedout = 1;
+                } else {
+                    pte->referenced = 1;
+                    if (inst.op == 'w' && !pte->write_protect) {
+                        pte->modified = 1;
+                        DEBUG(ctx, "DEBUG: Set modified=1 for proc %d, vpage %d (write)\n", ctx.current_process->pid, vpage);
+                    }
+                    if ((inst.op == 'r' || inst.op == 'w') && pte->file_mapped) {
+                        pte->modified = 1;
+                        DEBUG(ctx, "DEBUG: Set modified=1 for proc %d, vpage %d (file_mapped)\n", ctx.current_process->pid, vpage);
+                    }
+                }
+            }
+            ctx.cost += 1;
+            DEBUG(ctx, "DEBUG: Cost after instruction (%c %d) = %llu\n", inst.op, inst.value, ctx.cost);
+            DEBUG(ctx, "DEBUG: Processed %c %d, cost=%llu\n", inst.op, inst.value, ctx.cost);
+        }
+        ctx.inst_count++;
+        if (output_x && ctx.current_process) print_page_table(ctx, *ctx.current_process, false);
+        if (output_y) {
+            for (int i = 0; i < ctx.num_processes; ++i) print_page_table(ctx, ctx.processes[i], true);
+        }
+        if (output_f) {
+            fprintf(ctx.out, "FT:");
+            for (int i = 0; i < num_frames; ++i) {
+                if (ctx.frame_table[i].proc_id == -1) {
+                    fprintf(ctx.out, " *");
+                } else {
+                    fprintf(ctx.out, " %d:%d", ctx.frame_table[i].proc_id, ctx.frame_table[i].vpage);
+                }
+            }
+            fprintf(ctx.out, "\n");
+            DEBUG(ctx, "DEBUG: Frame table printed, free_frames size=%zu\n", ctx.free_frames.size());
+        }
+    }
+    if (output_P) {
+        for (int i = 0; i < ctx.num_processes; ++i) print_page_table(ctx, ctx.processes[i], true);
+    }
+    if (output_F) {
+        fprintf(ctx.out, "FT:");
+        for (int i = 0; i < num_frames; ++i) {
+            if (ctx.frame_table[i].proc_id == -1) {
+                fprintf(ctx.out, " *");
+            } else {
+                fprintf(ctx.out, " %d:%d", ctx.frame_table[i].proc_id, ctx.frame_table[i].vpage);
+            }
+        }
+        fprintf(ctx.out, "\n");
+    }
+    if (output_S) {
+        for (int i = 0; i < ctx.num_processes; ++i) {
+            const Process &proc = ctx.processes[i];
+            fprintf(ctx.out, "PROC[%d]: U=%lu M=%lu I=%lu O=%lu FI=%lu FO=%lu Z=%lu SV=%lu SP=%lu\n",
+                   proc.pid, proc.unmaps, proc.maps, proc.ins, proc.outs,
+                   proc.fins, proc.fouts, proc.zeros, proc.segv, proc.segprot);
+            DEBUG(ctx, "DEBUG: Proc %d stats: U=%lu M=%lu I=%lu O=%lu FI=%lu FO=%lu Z=%lu SV=%lu SP=%lu\n",
+                    proc.pid, proc.unmaps, proc.maps, proc.ins, proc.outs,
+                    proc.fins, proc.fouts, proc.zeros, proc.segv, proc.segprot);
+        }
+        fprintf(ctx.out, "TOTALCOST %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIzu "\n",
+               ctx.inst_count, ctx.ctx_switches, ctx.process_exits, ctx.cost, sizeof(pte_t));
+        DEBUG(ctx, "DEBUG: TOTALCOST inst=%llu ctx_switches=%llu exits=%llu cost=%llu\n",
+                ctx.inst_count, ctx.ctx_switches, ctx.process_exits, ctx.cost);
+    }
+}
@@ -0,0 +1,12 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "types.h"
+#include "pager.h"
+#include <string>
+
+bool read_input(SimContext &ctx, const std::string &filename);
+void init_frame_table(SimContext &ctx, int num_frames);
+void simulate(SimContext &ctx, Pager *pager, int num_frames, const std::string &options);
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <deque>
+#include <cstdio>
+#include <cstring>
 
 #define MAX_FRAMES 128
 #define MAX_VPAGES 64
@@ -44,4 +46,50 @@ struct Instruction {
     int value;
 };
 
+// FIFO of free frame numbers on a vector: popped slots are skipped by
+// head and reclaimed once the queue drains, so clear() keeps the storage.
+struct FrameQueue {
+    std::vector<int> slots;
+    size_t head;
+
+    FrameQueue() : head(0) {}
+    bool empty() const { return head == slots.size(); }
+    size_t size() const { return slots.size() - head; }
+    int front() const { return slots[head]; }
+    void push_back(int frame) { slots.push_back(frame); }
+    void pop_front() {
+        if (++head == slots.size()) clear();
+    }
+    void clear() {
+        slots.clear();
+        head = 0;
+    }
+};
+
+// All state of one simulation run. Batch workers keep one context each and
+// reset() it between jobs. Only the first num_processes entries of
+// processes belong to the current run; the rest are kept for reuse.
+struct SimContext {
+    std::vector<Process> processes;
+    int num_processes;
+    frame_t frame_table[MAX_FRAMES];
+    FrameQueue free_frames;
+    Process *current_process;
+    std::vector<Instruction> instructions;
+    unsigned long long inst_count, ctx_switches, process_exits, cost;
+    FILE *out;
+    FILE *dbg;
+
+    SimContext() : out(stdout), dbg(stderr) { reset(); }
+
+    void reset() {
+        std::memset(frame_table, 0, sizeof(frame_table));
+        num_processes = 0;
+        free_frames.clear();
+        current_process = nullptr;
+        instructions.clear();
+        inst_count = ctx_switches = process_exits = cost = 0;
+    }
+};
+
 #endif
\ No newline at end of file